@@ -1,4 +1,6 @@
 #include "gmv_proto.h"
+#include "gmv_stats.h"
+#include "gmv_subst.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,9 +13,6 @@
 #include <sys/shm.h>
 #include <signal.h>
 
-#define NUM_QUADROS QUADROS_PF
-#define BIT_R BIT_REFERENCIADA
-
 /* intervalo para zerar bits R (em acessos) */
 #define REF_CLEAR_INTERVAL 20
 
@@ -37,7 +36,7 @@ static void dump_tables_to_file(void) {
             entrada_tp_t *e = &g_tables_ptr[p].entradas[pg];
             int Pbit = (e->flags & BIT_PRESENCA) ? 1 : 0;
             int Mbit = (e->flags & BIT_MODIFICADA) ? 1 : 0;
-            int Rbit = (e->flags & BIT_REFERENCIADA) ? 1 : 0;
+            int Rbit = referenciada(e) ? 1 : 0;
             fprintf(tf, "%02d | %d %d %d |  %5d | %llu\n",
                     pg, Pbit, Mbit, Rbit,
                     e->quadro_fisico,
@@ -55,176 +54,12 @@ static void sigusr1_handler(int signo) {
     exit(0);
 }
 
-typedef struct {
-    bool ocupado;
-    int processo_id;       // índice do processo proprietário
-    uint8_t pagina_virtual;
-} quadro_t;
-
-static quadro_t memoria_fisica[NUM_QUADROS];
-static uint64_t tempo_global = 0;
 static int *contador_paginas_sujas_ptr = NULL;   // ponteiro para contador em memória compartilhada
 #define INC_PAG_SUJAS() do { if (contador_paginas_sujas_ptr) (*(contador_paginas_sujas_ptr))++; } while(0)
+static gmv_stats_t *g_stats = NULL;               // página de estatísticas lida pelo gmv_top
+static uint32_t quadros_por_processo[QTDE_FILHOS];
 
 
-/***************** Protótipos dos algoritmos de substituição ****************/
-// Cada função deve devolver o índice do quadro escolhido para substituição
-static int select_NRU(tabela_pagina_t *tabelas, int qtd_processos);
-static int select_2nCh(tabela_pagina_t *tabelas, int qtd_processos);
-static int select_LRU(tabela_pagina_t *tabelas, int qtd_processos, int proc_idx);
-static int select_WS(tabela_pagina_t *tabelas, int qtd_processos, int k, int proc_idx);
-
-/********************* Implementações simplificadas *************************/
-static int rand_quadro(void) { return rand() % NUM_QUADROS; }
-static int select_NRU(tabela_pagina_t *tabelas, int qtd_processos) {
-    //Resolvido - visto
-    int candidatos[4] = {-1, -1, -1, -1};
-
-    /* procura quadro livre imediatamente */
-    for (int i = 0; i < NUM_QUADROS; i++) {
-        if (!memoria_fisica[i].ocupado)
-            return i;
-    }
-
-    /* Classifica quadros ocupados nas 4 classes NRU */
-    for (int i = 0; i < NUM_QUADROS; i++) {
-        quadro_t *q = &memoria_fisica[i]; // q de quadro da memória RAM
-        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
-        uint8_t f = e->flags;
-        int classe;
-        if ((f & BIT_REFERENCIADA) == 0 && (f & BIT_MODIFICADA) == 0)        classe = 0;
-        else if ((f & BIT_REFERENCIADA) == 0 && (f & BIT_MODIFICADA))        classe = 1;
-        else if ((f & BIT_REFERENCIADA) && (f & BIT_MODIFICADA) == 0)        classe = 2;
-        else                                                                 classe = 3;
-        if (candidatos[classe] == -1)
-            candidatos[classe] = i;
-    }
-
-    /* devolve o primeiro candidato de menor classe disponível */
-    for (int c = 0; c < 4; c++){
-        if (candidatos[c] != -1){
-            return candidatos[c];
-        }
-    }
-    /* fallback improvável */
-    printf("NRU: fallback improvável\n");
-    return rand_quadro();
-}
-static int select_2nCh(tabela_pagina_t *tabelas, int qtd_processos) {
-    // Resolvido - visto
-    static int ponteiro = 0;
-
-    for (int tentativas = 0; tentativas < NUM_QUADROS * 2; tentativas++) {
-        int idx = ponteiro % NUM_QUADROS;
-        quadro_t *q = &memoria_fisica[idx];
-
-        if (!q->ocupado) return idx; // Se o quadro atual não estiver ocupado, retorna o índice do quadro
-
-        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
-
-        if ((e->flags & BIT_R) == 0){ // Se o bit R não estiver setado, retorna o índice do quadro
-            return idx;
-        } else {
-            e->flags &= ~BIT_R; // Se o bit R estiver setado, limpa o bit R
-        }
-
-        ponteiro = (ponteiro + 1) % NUM_QUADROS;
-    }
-    return ponteiro % NUM_QUADROS; 
-}
-static int select_LRU(tabela_pagina_t *tabelas, int qtd_processos, int proc_idx) {
-    // LRU com substituição local: prioriza quadros do próprio processo.
-
-    uint64_t menor_tempo_local = UINT64_MAX;
-    int indice_vitima_local = -1;
-
-    /* Primeiro: procura quadro livre; se encontrar, devolve imediatamente */
-    for (int i = 0; i < NUM_QUADROS; ++i) {
-        if (!memoria_fisica[i].ocupado)
-            return i;
-    }
-
-    /* Passo 1: procura LRU entre quadros pertencentes ao processo */
-    for (int i = 0; i < NUM_QUADROS; ++i) {
-        quadro_t *q = &memoria_fisica[i];
-        if (!q->ocupado || q->processo_id != proc_idx)
-            continue; // ignora quadros de outros processos
-
-        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
-        if (e->ultimo_acesso < menor_tempo_local) {
-            menor_tempo_local = e->ultimo_acesso;
-            indice_vitima_local = i;
-        }
-    }
-
-    if (indice_vitima_local != -1)
-        return indice_vitima_local;
-
-    /* Passo 2: processo não possui quadros (ou algum erro); faz fallback global */
-    uint64_t menor_tempo_global = UINT64_MAX;
-    int indice_vitima_global = -1;
-    for (int i = 0; i < NUM_QUADROS; ++i) {
-        quadro_t *q = &memoria_fisica[i];
-        if (!q->ocupado)
-            continue;
-        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
-        if (e->ultimo_acesso < menor_tempo_global) {
-            menor_tempo_global = e->ultimo_acesso;
-            indice_vitima_global = i;
-        }
-    }
-    return indice_vitima_global; // nunca deve ser -1 porque não há quadros livres nessa etapa
-}
-static int select_WS(tabela_pagina_t *tabelas, int qtd_processos, int k, int proc_idx) {
-    // Implementação com ponteiro circular para distribuir as vítimas.
-    static int ponteiro = 0;
-
-    uint64_t limite = tempo_global - k; // fronteira da janela k
-
-    int indice_fora_ws = -1;     // primeiro quadro fora do WS encontrado na varredura
-    int indice_mais_antigo = -1; // fallback LRU caso todos estejam no WS
-    uint64_t mais_antigo = UINT64_MAX;
-
-    for (int passo = 0; passo < NUM_QUADROS; ++passo) {
-        int i = (ponteiro + passo) % NUM_QUADROS;
-
-        if (!memoria_fisica[i].ocupado) {
-            // quadro livre pode ser usado por qualquer processo
-            ponteiro = (i + 1) % NUM_QUADROS;
-            return i;
-        }
-
-        // Apenas considera quadros pertencentes ao mesmo processo (substituição local)
-        if (memoria_fisica[i].processo_id != proc_idx) {
-            continue;
-        }
-
-        quadro_t *q = &memoria_fisica[i];
-        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
-
-        if (e->ultimo_acesso < limite && indice_fora_ws == -1) {
-            indice_fora_ws = i; // primeiro quadro desse processo fora do WS
-        }
-
-        if (e->ultimo_acesso < mais_antigo) {
-            mais_antigo = e->ultimo_acesso;
-            indice_mais_antigo = i;
-        }
-    }
-
-    // Atualiza ponteiro para próximo quadro após a vítima escolhida
-    int escolhido = (indice_fora_ws != -1) ? indice_fora_ws : indice_mais_antigo;
-
-    if (escolhido == -1) {
-        // Situação inesperada: processo não tem quadros próprios e não há livres.
-        // Faz fallback para escolha global via ponteiro.
-        escolhido = ponteiro;
-    }
-
-    ponteiro = (escolhido + 1) % NUM_QUADROS;
-    return escolhido;
-}
-
 /********************* Servidor GMV via FIFO *********************************/
 static const char *FIFO_DIR = "./FIFOs";
 static const char *FIFO_REQ = "./FIFOs/gmv_req";
@@ -237,10 +72,96 @@ static int pid_to_index(pid_t pid) {
     return -1;
 }
 
+/* Zera todos os bits R em O(1); só percorre as tabelas quando a época dá a volta */
 static void limpa_bits_referencia(tabela_pagina_t *tabelas, int qtd_proc) {
+    if (++epoca_ref_atual != 0) return;
     for (int p = 0; p < qtd_proc; ++p)
         for (int i = 0; i < ENTRADAS_TP; ++i)
-            tabelas[p].entradas[i].flags &= ~BIT_REFERENCIADA;
+            limpa_referencia(&tabelas[p].entradas[i]);
+    epoca_ref_atual = 1;
+}
+
+/* Working set publicado: páginas residentes referenciadas nas últimas k+1
+ * requisições globais (mesmo critério do select_WS). Uma janela circular
+ * indexada por tempo_global mantém as contagens em O(1) por requisição. */
+typedef struct { int8_t proc; uint8_t pagina; } ref_janela_t;
+static ref_janela_t *ws_janela = NULL;      // NULL = estatística desligada
+static uint64_t ws_tamanho = 0;
+static uint32_t ws_ocorrencias[QTDE_FILHOS][ENTRADAS_TP];
+static uint32_t ws_contagem[QTDE_FILHOS];
+static uint32_t ws_publicado[QTDE_FILHOS];
+
+static void ws_inicia(int k) {
+    ws_tamanho = (uint64_t)(k > 0 ? k : 0) + 1;
+    ws_janela = malloc(ws_tamanho * sizeof(*ws_janela));
+    if (!ws_janela) { perror("malloc janela WS"); return; }
+    for (uint64_t i = 0; i < ws_tamanho; ++i) ws_janela[i].proc = -1;
+}
+
+/* tempo_global acabou de avançar: a referência de k+1 tempos atrás sai da janela */
+static void ws_avanca(tabela_pagina_t *tabelas) {
+    if (!ws_janela) return;
+    ref_janela_t *r = &ws_janela[tempo_global % ws_tamanho];
+    if (r->proc < 0) return;
+    if (--ws_ocorrencias[r->proc][r->pagina] == 0 &&
+        (tabelas[r->proc].entradas[r->pagina].flags & BIT_PRESENCA))
+        ws_contagem[r->proc]--;
+    r->proc = -1;
+}
+
+static void ws_despejo(int proc, uint8_t pagina) {
+    if (ws_janela && ws_ocorrencias[proc][pagina] > 0) ws_contagem[proc]--;
+}
+
+static void ws_carga(int proc, uint8_t pagina) {
+    if (ws_janela && ws_ocorrencias[proc][pagina] > 0) ws_contagem[proc]++;
+}
+
+/* Página (já residente) referenciada no tempo atual */
+static void ws_referencia(int proc, uint8_t pagina) {
+    if (!ws_janela) return;
+    ws_janela[tempo_global % ws_tamanho] = (ref_janela_t){ (int8_t)proc, pagina };
+    if (ws_ocorrencias[proc][pagina]++ == 0) ws_contagem[proc]++;
+}
+
+/* Atualiza contadores do processo que perdeu um quadro */
+static void stats_registra_despejo(int proc, int dirty) {
+    if (!g_stats) return;
+    stats_proc_t *sp = &g_stats->proc[proc];
+    stats_escrita_inicio(sp);
+    if (dirty) STATS_ADD(sp->sujas_despejadas, 1);
+    STATS_SET(sp->quadros_ocupados, quadros_por_processo[proc]);
+    stats_escrita_fim(sp);
+}
+
+/* Publica o WS dos demais processos apenas quando a contagem mudou
+ * (páginas saem da janela mesmo de processos parados pelo escalonador) */
+static void stats_publica_working_sets(int proc_atual) {
+    for (int p = 0; p < QTDE_FILHOS; ++p) {
+        if (p == proc_atual || ws_contagem[p] == ws_publicado[p]) continue;
+        stats_proc_t *sp = &g_stats->proc[p];
+        stats_escrita_inicio(sp);
+        STATS_SET(sp->working_set, ws_contagem[p]);
+        stats_escrita_fim(sp);
+        ws_publicado[p] = ws_contagem[p];
+    }
+}
+
+/* Atualiza contadores do processo que fez a requisição */
+static void stats_registra_acesso(int proc, pid_t pid, int page_fault) {
+    if (!g_stats) return;
+    stats_proc_t *sp = &g_stats->proc[proc];
+    stats_escrita_inicio(sp);
+    STATS_SET(sp->pid, pid);
+    STATS_ADD(sp->referencias, 1);
+    if (page_fault) STATS_ADD(sp->page_faults, 1);
+    else            STATS_ADD(sp->hits, 1);
+    STATS_SET(sp->quadros_ocupados, quadros_por_processo[proc]);
+    STATS_SET(sp->working_set, ws_contagem[proc]);
+    stats_escrita_fim(sp);
+    ws_publicado[proc] = ws_contagem[proc];
+    stats_publica_working_sets(proc);
+    STATS_SET(g_stats->tempo_global, tempo_global);
 }
 
 int main(int argc, char *argv[]) {
@@ -261,6 +182,10 @@ int main(int argc, char *argv[]) {
     if (contador_paginas_sujas_ptr == (void *)-1) { perror("shmat"); return EXIT_FAILURE; }
     *contador_paginas_sujas_ptr = 0;
 
+    /* página de estatísticas ao vivo (opcional: falha não impede o GMV) */
+    g_stats = gmv_stats_anexar(1, 0);
+    if (!g_stats) perror("shm stats");
+    else ws_inicia(k);
 
     /* garante diretório de FIFOs */
     mkdir(FIFO_DIR, 0777);
@@ -310,6 +235,7 @@ int main(int argc, char *argv[]) {
         }
 
         tempo_global++;
+        ws_avanca(tabelas);
         if (tempo_global % REF_CLEAR_INTERVAL == 0)
             limpa_bits_referencia(tabelas, QTDE_FILHOS);
 
@@ -347,12 +273,18 @@ int main(int argc, char *argv[]) {
                     INC_PAG_SUJAS();
                     dirty_log = 1;
                 }
+                quadros_por_processo[py_log]--;
+                ws_despejo(py_log, pagy_log);
+                stats_registra_despejo(py_log, dirty_log);
             }
+            quadros_por_processo[idx]++;
             memoria_fisica[quadro].ocupado = true;
             memoria_fisica[quadro].processo_id = idx;
             memoria_fisica[quadro].pagina_virtual = req.pagina;
             entry->quadro_fisico = quadro;
             entry->flags = BIT_PRESENCA;
+            ws_carga(idx, req.pagina);
+            limpa_referencia(entry);
             page_fault = 1;
 
             /* grava no arquivo de log */
@@ -378,10 +310,13 @@ int main(int argc, char *argv[]) {
                        quadro,
                        dirty_log ? " [dirty]" : "");
         }
-        entry->flags |= BIT_REFERENCIADA;
+        marca_referencia(entry);
         if (req.operacao == 'W') entry->flags |= BIT_MODIFICADA;
         entry->ultimo_acesso = tempo_global;
 
+        ws_referencia(idx, req.pagina);
+        stats_registra_acesso(idx, req.pid, page_fault);
+
         /* Envia resposta */
         char fifo_resp[64];
         snprintf(fifo_resp, sizeof(fifo_resp), "./FIFOs/gmv_resp_%d", req.pid);
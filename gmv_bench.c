@@ -0,0 +1,614 @@
+/* gmv_bench.c – Benchmarks dos algoritmos de substituição e da vazão do GMV
+ *
+ * Compilação (o número de quadros é fixo em tempo de compilação):
+ *   gcc -O2 -o gmv gmv.c gmv_subst.c
+ *   gcc -O2 -o gmv_bench gmv_bench.c gmv_subst.c
+ *   gcc -O2 -DQUADROS_PF=64 -o gmv_bench64 gmv_bench.c gmv_subst.c
+ *
+ * Uso: ./gmv_bench [--micro|--macro] [--gmv ./gmv] [--clientes N] [--refs M]
+ *                  [--saida arq.csv] [--baseline arq.csv] [--tolerancia pct]
+ *
+ * Resultados em CSV: tipo,algoritmo,quadros,cenario,metrica,valor
+ *   ns_op  – nanossegundos por escolha de vítima (menor é melhor); a linha
+ *            'calib' mede um laço fixo, independente do GMV, usado para
+ *            descontar variações de velocidade da máquina entre execuções
+ *            (também no macro, que tem sua própria linha 'calib'). Só conta
+ *            como regressão o que piora no valor bruto e no escalado.
+ *            2nCH inclui restaurar apenas os bits R que a própria chamada limpou.
+ *   refs_s – referências por segundo através do GMV (maior é melhor)
+ * Com --baseline, qualquer métrica pior que a tolerância encerra com status 1
+ * (após repetir a medição e ficar com o melhor valor de cada linha), assim
+ * como qualquer resultado sem linha correspondente no baseline (outros
+ * --clientes/--refs, outro QUADROS_PF ou modo não medido no baseline).
+ *
+ * O benchmark se reexecuta com ASLR desligado, para que o layout do código seja
+ * o mesmo em todas as execuções de um mesmo binário.
+ *
+ * O macrobenchmark sobe um GMV próprio em diretório temporário; não execute
+ * junto com outra simulação, pois os segmentos em /tmp são compartilhados.
+ */
+#define _GNU_SOURCE   /* sched_setaffinity / sched_getcpu */
+#include "gmv_proto.h"
+#include "gmv_stats.h"
+#include "gmv_subst.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/personality.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FIFO_DIR "./FIFOs"
+#define FIFO_REQ "./FIFOs/gmv_req"
+
+#define MICRO_LOTE       10000       // chamadas entre leituras do relógio
+#define MICRO_AMOSTRA_NS 100e6       // duração mínima de cada amostra
+#define MICRO_REPETICOES 11          // amostras por medição; usa a mediana
+#define MACRO_REPETICOES 5           // execuções por algoritmo; usa a mediana
+#define MACRO_TIMEOUT_MS 5000        // espera máxima pelo GMV (abrir FIFO / resposta)
+#define FOLGA_NS         3.0         // ruído absoluto tolerado em ns_op
+#define MAX_RESULTADOS   128
+
+typedef struct {
+    char tipo[8];
+    char algoritmo[8];
+    int  quadros;
+    char cenario[24];
+    char metrica[8];
+    double valor;
+} resultado_t;
+
+static resultado_t resultados[MAX_RESULTADOS];
+static int qtd_resultados = 0;
+
+static void registra(const char *tipo, const char *alg, int quadros,
+                     const char *cenario, const char *metrica, double valor) {
+    if (qtd_resultados >= MAX_RESULTADOS) return;
+    resultado_t *r = &resultados[qtd_resultados++];
+    snprintf(r->tipo, sizeof(r->tipo), "%s", tipo);
+    snprintf(r->algoritmo, sizeof(r->algoritmo), "%s", alg);
+    r->quadros = quadros;
+    snprintf(r->cenario, sizeof(r->cenario), "%s", cenario);
+    snprintf(r->metrica, sizeof(r->metrica), "%s", metrica);
+    r->valor = valor;
+}
+
+static double agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/********************* Microbenchmark ***************************************/
+static const char *ALGORITMOS[] = {"NRU", "2nCH", "LRU", "WS"};
+#define QTD_ALGORITMOS 4
+
+typedef enum { METADE_LIVRE, CHEIA_LIMPA, CHEIA_REF_MOD, MISTA, QTD_CENARIOS } cenario_t;
+static const char *NOMES_CENARIO[] = {"metade_livre", "cheia_limpa", "cheia_ref_mod", "mista"};
+
+/* Estado de partida de cada cenário */
+static quadro_t        modelo_memoria[NUM_QUADROS];
+static tabela_pagina_t modelo_tabelas[QTDE_FILHOS];
+static tabela_pagina_t bench_tabelas[QTDE_FILHOS];
+
+static void monta_cenario(cenario_t c) {
+    memset(modelo_memoria, 0, sizeof(modelo_memoria));
+    memset(modelo_tabelas, 0, sizeof(modelo_tabelas));
+    srand(1234);
+    tempo_global = 1000;
+    for (int i = 0; i < NUM_QUADROS; ++i) {
+        if (c == METADE_LIVRE && i < NUM_QUADROS / 2) continue; // livres no fim da varredura
+        int proc = i % QTDE_FILHOS;
+        int pag  = (i / QTDE_FILHOS) % ENTRADAS_TP;
+        modelo_memoria[i].ocupado = true;
+        modelo_memoria[i].processo_id = proc;
+        modelo_memoria[i].pagina_virtual = (uint8_t)pag;
+
+        entrada_tp_t *e = &modelo_tabelas[proc].entradas[pag];
+        e->quadro_fisico = i;
+        e->flags = BIT_PRESENCA;
+        e->ultimo_acesso = tempo_global - 1; // todos dentro da janela do WS
+        if (c == CHEIA_REF_MOD || (c == MISTA && rand() % 2))
+            marca_referencia(e);
+        if (c == CHEIA_REF_MOD || (c == MISTA && rand() % 2))
+            e->flags |= BIT_MODIFICADA;
+        if (c == MISTA)
+            e->ultimo_acesso = tempo_global - (uint64_t)(rand() % 10);
+    }
+    if (c == METADE_LIVRE) {
+        /* quadros livres ficam depois dos ocupados para forçar a varredura */
+        quadro_t tmp[NUM_QUADROS];
+        int n = 0;
+        for (int i = 0; i < NUM_QUADROS; ++i) if (modelo_memoria[i].ocupado)  tmp[n++] = modelo_memoria[i];
+        for (int i = 0; i < NUM_QUADROS; ++i) if (!modelo_memoria[i].ocupado) tmp[n++] = modelo_memoria[i];
+        memcpy(modelo_memoria, tmp, sizeof(tmp));
+        for (int i = 0; i < NUM_QUADROS; ++i)
+            if (modelo_memoria[i].ocupado)
+                modelo_tabelas[modelo_memoria[i].processo_id]
+                    .entradas[modelo_memoria[i].pagina_virtual].quadro_fisico = i;
+    }
+}
+
+/* Apenas select_2nCh altera as tabelas, limpando o bit R dos quadros por onde
+ * passa. O ponteiro dele para na vítima, então a varredura de uma chamada vai
+ * da vítima anterior até a atual; se as duas coincidem, ou nada foi limpo
+ * (quadro já tinha R = 0) ou a volta foi completa. Só esses quadros voltam ao
+ * estado do modelo, para o custo da restauração não diluir o da varredura. */
+static int ponteiro_2nch = 0;   // espelho do ponteiro estático de select_2nCh
+
+static inline void restaura_quadro(int i) {
+    quadro_t *q = &modelo_memoria[i];
+    if (!q->ocupado) return;
+    bench_tabelas[q->processo_id].entradas[q->pagina_virtual].epoca_ref =
+        modelo_tabelas[q->processo_id].entradas[q->pagina_virtual].epoca_ref;
+}
+
+static inline void restaura_varridos(int vitima) {
+    int i = ponteiro_2nch;
+    quadro_t *q = &modelo_memoria[i];
+    if (vitima == i &&
+        q->ocupado && referenciada(&modelo_tabelas[q->processo_id].entradas[q->pagina_virtual])) {
+        for (int n = 0; n < NUM_QUADROS; ++n) restaura_quadro(n);
+    } else {
+        for (; i != vitima; i = (i + 1) % NUM_QUADROS) restaura_quadro(i);
+    }
+    ponteiro_2nch = vitima;
+}
+
+static volatile int sumidouro;
+
+/* Laço de referência: cadeia de multiplicações dependentes, sem desvios nem
+ * memória, cujo tempo depende só da velocidade do núcleo e não do layout do
+ * binário (senão mudar código alheio ao GMV alteraria a calibração) */
+#define CALIB_PASSOS 16
+
+static __attribute__((noinline, aligned(64))) int calibracao(int semente) {
+    uint64_t x = (uint64_t)semente + 1;
+    for (int i = 0; i < CALIB_PASSOS; ++i)
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+    return (int)(x >> 60);
+}
+
+/* alg == -1 mede o laço de calibração.
+ * Executa lotes até completar MICRO_AMOSTRA_NS e devolve ns por chamada. */
+static double mede_ns(int alg) {
+    memcpy(memoria_fisica, modelo_memoria, sizeof(memoria_fisica));
+    memcpy(bench_tabelas, modelo_tabelas, sizeof(bench_tabelas));
+    long chamadas = 0;
+    double t0 = agora_ns(), dt;
+    do {
+        for (int it = 0; it < MICRO_LOTE; ++it) {
+            int proc = it % QTDE_FILHOS;
+            switch (alg) {
+                case -1: sumidouro = calibracao(proc); break;
+                case 0: sumidouro = select_NRU(bench_tabelas, QTDE_FILHOS); break;
+                case 1: {
+                    int v = select_2nCh(bench_tabelas, QTDE_FILHOS);
+                    restaura_varridos(v);
+                    sumidouro = v;
+                    break;
+                }
+                case 2: sumidouro = select_LRU(bench_tabelas, QTDE_FILHOS, proc); break;
+                default: sumidouro = select_WS(bench_tabelas, QTDE_FILHOS, 3, proc); break;
+            }
+        }
+        chamadas += MICRO_LOTE;
+        dt = agora_ns() - t0;
+    } while (dt < MICRO_AMOSTRA_NS);
+    return dt / chamadas;
+}
+
+static int compara_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double mediana(double *amostras, int n) {
+    qsort(amostras, n, sizeof(double), compara_double);
+    return amostras[n / 2];
+}
+
+static void executa_micro(void) {
+    /* fixa a CPU atual: migrações entre núcleos distorcem amostras curtas.
+     * A afinidade original é restaurada para não prender o GMV do macro. */
+    cpu_set_t original, cpus;
+    sched_getaffinity(0, sizeof(original), &original);
+    CPU_ZERO(&cpus);
+    CPU_SET(sched_getcpu(), &cpus);
+    sched_setaffinity(0, sizeof(cpus), &cpus);
+
+    double razoes[QTD_CENARIOS][QTD_ALGORITMOS][MICRO_REPETICOES];
+    double calib[QTD_CENARIOS * MICRO_REPETICOES];
+    for (int c = 0; c < QTD_CENARIOS; ++c) {
+        monta_cenario((cenario_t)c);
+        /* cada amostra é dividida pela calibração tomada logo antes, de modo que
+         * variações lentas de velocidade da máquina se cancelam */
+        for (int r = 0; r < MICRO_REPETICOES; ++r) {
+            double cal = mede_ns(-1);
+            calib[c * MICRO_REPETICOES + r] = cal;
+            for (int a = 0; a < QTD_ALGORITMOS; ++a)
+                razoes[c][a][r] = mede_ns(a) / cal;
+        }
+    }
+    sched_setaffinity(0, sizeof(original), &original);
+    double cal = mediana(calib, QTD_CENARIOS * MICRO_REPETICOES);
+    registra("micro", "calib", NUM_QUADROS, "-", "ns_op", cal);
+    for (int c = 0; c < QTD_CENARIOS; ++c)
+        for (int a = 0; a < QTD_ALGORITMOS; ++a)
+            registra("micro", ALGORITMOS[a], NUM_QUADROS, NOMES_CENARIO[c], "ns_op",
+                     cal * mediana(razoes[c][a], MICRO_REPETICOES));
+}
+
+/********************* Macrobenchmark ***************************************/
+/* Abre a FIFO de requisições sem bloquear para sempre se o GMV não subir */
+static int abre_fifo_req(void) {
+    for (int ms = 0; ms < MACRO_TIMEOUT_MS; ++ms) {
+        int fd = open(FIFO_REQ, O_WRONLY | O_NONBLOCK);
+        if (fd >= 0) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+            return fd;
+        }
+        if (errno != ENXIO) break; // ENXIO: ainda não há leitor
+        usleep(1000);
+    }
+    return -1;
+}
+
+/* Cliente sintético: avisa em 'pronto' ao conectar, aguarda o fechamento de
+ * 'largada' e então envia 'refs' pedidos sem pausas, esperando cada resposta */
+static void cliente_sintetico(int id, int refs, int pronto, int largada) {
+    int fd_req = abre_fifo_req();
+    if (fd_req < 0) { fprintf(stderr, "cliente bench: GMV não abriu a FIFO\n"); _exit(EXIT_FAILURE); }
+    char fifo_resp[64];
+    snprintf(fifo_resp, sizeof(fifo_resp), "./FIFOs/gmv_resp_%d", getpid());
+    mkfifo(fifo_resp, 0666);
+    int fd_resp = open(fifo_resp, O_RDWR);
+    if (fd_resp < 0) { perror("open resp fifo (bench)"); _exit(EXIT_FAILURE); }
+
+    char c = 1, lixo;
+    if (write(pronto, &c, 1) != 1) _exit(EXIT_FAILURE);
+    close(pronto);
+    while (read(largada, &lixo, 1) > 0) ; // EOF = largada
+    close(largada);
+
+    unsigned int semente = 42u + (unsigned int)id;
+    for (int i = 0; i < refs; ++i) {
+        req_t req = { .pid = getpid(),
+                      .pagina = (uint8_t)(rand_r(&semente) % ENTRADAS_TP),
+                      .operacao = (rand_r(&semente) % 2) ? 'W' : 'R' };
+        resp_t resp;
+        struct pollfd pfd = { .fd = fd_resp, .events = POLLIN };
+        if (write(fd_req, &req, sizeof(req)) != sizeof(req) ||
+            poll(&pfd, 1, MACRO_TIMEOUT_MS) != 1 ||
+            read(fd_resp, &resp, sizeof(resp)) != sizeof(resp)) {
+            fprintf(stderr, "cliente bench: GMV não respondeu\n");
+            unlink(fifo_resp);
+            _exit(EXIT_FAILURE);
+        }
+    }
+    close(fd_req);
+    close(fd_resp);
+    unlink(fifo_resp);
+    _exit(EXIT_SUCCESS);
+}
+
+/* Mata e recolhe o GMV e os clientes já criados (caminhos de erro) */
+static void encerra_processos(pid_t gpid, const pid_t *pids, int n) {
+    for (int c = 0; c < n; ++c) kill(pids[c], SIGKILL);
+    if (gpid > 0) kill(gpid, SIGKILL);
+    for (int c = 0; c < n; ++c) waitpid(pids[c], NULL, 0);
+    if (gpid > 0) waitpid(gpid, NULL, 0);
+}
+
+static int executa_macro_alg(const char *gmv_bin, const char *alg, int clientes, int refs,
+                             int *quadros, double *refs_s) {
+    /* cria FIFO antes do GMV para que os clientes não corram contra o mkfifo dele */
+    mkdir(FIFO_DIR, 0777);
+    mkfifo(FIFO_REQ, 0666);
+
+    pid_t gpid = fork();
+    if (gpid < 0) { perror("fork gmv"); return -1; }
+    if (gpid == 0) {
+        int nul = open("/dev/null", O_WRONLY);
+        if (nul >= 0) { dup2(nul, STDOUT_FILENO); close(nul); }
+        execl(gmv_bin, gmv_bin, alg, "3", (char *)NULL);
+        perror("exec gmv");
+        _exit(EXIT_FAILURE);
+    }
+
+    int pronto[2], largada[2];
+    if (pipe(pronto) != 0 || pipe(largada) != 0) {
+        perror("pipe");
+        encerra_processos(gpid, NULL, 0);
+        return -1;
+    }
+
+    pid_t pids[QTDE_FILHOS];
+    int criados = 0;
+    for (; criados < clientes; ++criados) {
+        pids[criados] = fork();
+        if (pids[criados] < 0) break;
+        if (pids[criados] == 0) {
+            close(pronto[0]);
+            close(largada[1]);
+            cliente_sintetico(criados, refs, pronto[1], largada[0]);
+        }
+    }
+    close(pronto[1]);
+    close(largada[0]);
+    if (criados < clientes) {
+        perror("fork cliente");
+        close(pronto[0]);
+        close(largada[1]);
+        encerra_processos(gpid, pids, criados);
+        return -1;
+    }
+
+    /* relógio parte só quando todos os clientes estão conectados ao GMV */
+    int conectados = 0;
+    char c;
+    while (conectados < clientes && read(pronto[0], &c, 1) == 1) conectados++;
+    close(pronto[0]);
+    double t0 = agora_ns();
+    close(largada[1]);
+
+    int falhou = (conectados < clientes);
+    for (int i = 0; i < clientes; ++i) {
+        int status;
+        waitpid(pids[i], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) falhou = 1;
+    }
+    double dt = (agora_ns() - t0) / 1e9;
+
+    if (falhou || waitpid(gpid, NULL, WNOHANG) != 0) {
+        fprintf(stderr, "macro %s: GMV ou cliente falhou\n", alg);
+        encerra_processos(gpid, NULL, 0);
+        return -1;
+    }
+
+    /* quadros reais do binário GMV, publicados na página de estatísticas */
+    *quadros = NUM_QUADROS;
+    gmv_stats_t *st = gmv_stats_anexar(0, 1);
+    if (gmv_stats_valido(st)) *quadros = (int)st->quadros;
+    if (st) shmdt(st);
+
+    kill(gpid, SIGUSR1);
+    waitpid(gpid, NULL, 0);
+
+    *refs_s = (double)clientes * refs / dt;
+    return 0;
+}
+
+/* Apaga o conteúdo de 'dir' (um nível) e o próprio diretório */
+static void remove_diretorio(const char *dir) {
+    DIR *d = opendir(dir);
+    if (d) {
+        struct dirent *ent;
+        char caminho[PATH_MAX];
+        while ((ent = readdir(d)) != NULL) {
+            if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+            snprintf(caminho, sizeof(caminho), "%s/%s", dir, ent->d_name);
+            unlink(caminho);
+        }
+        closedir(d);
+    }
+    rmdir(dir);
+}
+
+static int executa_macro(const char *gmv_bin, int clientes, int refs) {
+    char gmv_abs[PATH_MAX];
+    if (!realpath(gmv_bin, gmv_abs)) { perror(gmv_bin); return -1; }
+
+    char dir[] = "/tmp/gmv_bench_XXXXXX";
+    if (!mkdtemp(dir)) { perror("mkdtemp"); return -1; }
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd)) || chdir(dir) != 0) {
+        perror("chdir");
+        rmdir(dir);
+        return -1;
+    }
+
+    /* execuções intercaladas entre algoritmos; cada vazão é multiplicada pela
+     * calibração tomada logo antes, como no microbenchmark */
+    int rc = 0;
+    int quadros[QTD_ALGORITMOS];
+    double normalizadas[QTD_ALGORITMOS][MACRO_REPETICOES];
+    double calib[QTD_ALGORITMOS * MACRO_REPETICOES];
+    for (int r = 0; r < MACRO_REPETICOES && rc == 0; ++r) {
+        for (int a = 0; a < QTD_ALGORITMOS && rc == 0; ++a) {
+            double cal = mede_ns(-1), v = 0;
+            calib[r * QTD_ALGORITMOS + a] = cal;
+            rc = executa_macro_alg(gmv_abs, ALGORITMOS[a], clientes, refs, &quadros[a], &v);
+            normalizadas[a][r] = v * cal;
+        }
+    }
+    if (rc == 0) {
+        char cenario[24];
+        snprintf(cenario, sizeof(cenario), "%dc_%dr", clientes, refs);
+        double cal = mediana(calib, QTD_ALGORITMOS * MACRO_REPETICOES);
+        registra("macro", "calib", quadros[0], cenario, "ns_op", cal);
+        for (int a = 0; a < QTD_ALGORITMOS; ++a)
+            registra("macro", ALGORITMOS[a], quadros[a], cenario, "refs_s",
+                     mediana(normalizadas[a], MACRO_REPETICOES) / cal);
+    }
+
+    if (chdir(cwd) != 0) perror("chdir");
+    char fifos[PATH_MAX];
+    snprintf(fifos, sizeof(fifos), "%s/FIFOs", dir);
+    remove_diretorio(fifos);
+    remove_diretorio(dir);
+    return rc;
+}
+
+/********************* Saída e comparação com baseline **********************/
+static void grava_csv(FILE *f) {
+    fprintf(f, "tipo,algoritmo,quadros,cenario,metrica,valor\n");
+    for (int i = 0; i < qtd_resultados; ++i) {
+        resultado_t *r = &resultados[i];
+        fprintf(f, "%s,%s,%d,%s,%s,%.3f\n",
+                r->tipo, r->algoritmo, r->quadros, r->cenario, r->metrica, r->valor);
+    }
+}
+
+static resultado_t *busca(resultado_t *v, int n, const resultado_t *chave, const char *algoritmo) {
+    for (int i = 0; i < n; ++i)
+        if (strcmp(v[i].tipo, chave->tipo) == 0 && strcmp(v[i].algoritmo, algoritmo) == 0 &&
+            v[i].quadros == chave->quadros && strcmp(v[i].cenario, chave->cenario) == 0 &&
+            strcmp(v[i].metrica, chave->metrica) == 0)
+            return &v[i];
+    return NULL;
+}
+
+/* Devolve o número de regressões mais o de resultados sem correspondente no
+ * baseline; -1 se não conseguir ler ou se nada corresponder.
+ * Tempos micro são escalados pela razão entre as calibrações das duas execuções. */
+/* Devolve regressões + resultados sem par (-1 se nada casou); 'regressoes'
+ * recebe só as regressões, que justificam repetir a medição */
+static int compara_baseline(const char *arquivo, double tolerancia, int *regressoes_out) {
+    FILE *f = fopen(arquivo, "r");
+    if (!f) { perror(arquivo); return -1; }
+    static resultado_t base[MAX_RESULTADOS];
+    int qtd_base = 0;
+    char linha[256];
+    while (qtd_base < MAX_RESULTADOS && fgets(linha, sizeof(linha), f)) {
+        resultado_t *b = &base[qtd_base];
+        if (sscanf(linha, "%7[^,],%7[^,],%d,%23[^,],%7[^,],%lf",
+                   b->tipo, b->algoritmo, &b->quadros, b->cenario, b->metrica, &b->valor) == 6)
+            qtd_base++; // ignora cabeçalho e linhas inválidas
+    }
+    fclose(f);
+
+    int regressoes = 0, sem_par = 0, comparados = 0;
+    for (int i = 0; i < qtd_resultados; ++i) {
+        resultado_t *r = &resultados[i];
+        resultado_t *b = busca(base, qtd_base, r, r->algoritmo);
+        if (!b) {
+            fprintf(stderr, "SEM BASELINE %s %s q=%d %s %s\n",
+                    r->tipo, r->algoritmo, r->quadros, r->cenario, r->metrica);
+            sem_par++;
+            continue;
+        }
+        if (strcmp(r->algoritmo, "calib") == 0) continue;
+        comparados++;
+        bool regrediu;
+        double esperado = b->valor;
+        /* calibração da mesma execução: micro tem uma só, macro uma por cenário */
+        resultado_t chave_cal = *r;
+        snprintf(chave_cal.metrica, sizeof(chave_cal.metrica), "ns_op");
+        if (strcmp(r->tipo, "micro") == 0)
+            snprintf(chave_cal.cenario, sizeof(chave_cal.cenario), "-");
+        resultado_t *cal_r = busca(resultados, qtd_resultados, &chave_cal, "calib");
+        resultado_t *cal_b = busca(base, qtd_base, &chave_cal, "calib");
+        double escala = (cal_r && cal_b && cal_b->valor > 0) ? cal_r->valor / cal_b->valor : 1.0;
+        /* regressão só se pior tanto no valor bruto quanto no escalado: a própria
+         * calibração oscila, e exigir os dois evita falso alarme de qualquer lado */
+        if (strcmp(r->metrica, "refs_s") == 0) {
+            double limite = (escala > 1.0 ? b->valor / escala : b->valor) * (1.0 - tolerancia);
+            esperado /= escala;
+            regrediu = r->valor < limite;
+        } else {
+            double limite = escala > 1.0 ? b->valor * escala : b->valor;
+            esperado *= escala;
+            regrediu = r->valor > limite * (1.0 + tolerancia) &&
+                       r->valor - limite > FOLGA_NS;
+        }
+        if (regrediu) {
+            fprintf(stderr, "REGRESSAO %s %s q=%d %s %s: %.3f -> %.3f (esperado %.3f)\n",
+                    r->tipo, r->algoritmo, r->quadros, r->cenario, r->metrica,
+                    b->valor, r->valor, esperado);
+            regressoes++;
+        }
+    }
+    if (comparados == 0) {
+        fprintf(stderr, "%s: nenhum resultado corresponde ao baseline\n", arquivo);
+        return -1;
+    }
+    *regressoes_out = regressoes;
+    return regressoes + sem_par;
+}
+
+/* Mantém em resultados[] o melhor valor de cada linha entre duas execuções */
+static void melhor_de(const resultado_t *anteriores, int n) {
+    for (int i = 0; i < qtd_resultados; ++i) {
+        resultado_t *r = &resultados[i];
+        const resultado_t *a = busca((resultado_t *)anteriores, n, r, r->algoritmo);
+        if (!a) continue;
+        if (strcmp(r->metrica, "refs_s") == 0 ? a->valor > r->valor : a->valor < r->valor)
+            r->valor = a->valor;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    /* com ASLR cada execução cai num layout de código diferente e os tempos
+     * oscilam entre processos bem mais que dentro de um; reexecuta sem ele
+     * (se não der, segue assim mesmo) */
+    int persona = personality(0xffffffff);
+    if (persona != -1 && !(persona & ADDR_NO_RANDOMIZE) &&
+        personality(persona | ADDR_NO_RANDOMIZE) != -1)
+        execv("/proc/self/exe", argv);
+
+    bool micro = true, macro = true;
+    const char *gmv_bin = "./gmv";
+    const char *saida = NULL, *baseline = NULL;
+    int clientes = QTDE_FILHOS, refs = 10000;
+    double tolerancia = 0.25;
+
+    for (int i = 1; i < argc; ++i) {
+        if      (strcmp(argv[i], "--micro") == 0) macro = false;
+        else if (strcmp(argv[i], "--macro") == 0) micro = false;
+        else if (strcmp(argv[i], "--gmv") == 0 && i + 1 < argc)        gmv_bin = argv[++i];
+        else if (strcmp(argv[i], "--clientes") == 0 && i + 1 < argc)   clientes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--refs") == 0 && i + 1 < argc)       refs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc)      saida = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)   baseline = argv[++i];
+        else if (strcmp(argv[i], "--tolerancia") == 0 && i + 1 < argc) tolerancia = atof(argv[++i]) / 100.0;
+        else {
+            fprintf(stderr, "Uso: %s [--micro|--macro] [--gmv bin] [--clientes N] [--refs M]\n"
+                            "       [--saida arq.csv] [--baseline arq.csv] [--tolerancia pct]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    /* o GMV só mapeia QTDE_FILHOS pids distintos */
+    if (clientes < 1 || clientes > QTDE_FILHOS) clientes = QTDE_FILHOS;
+    if (refs < 1) refs = 1;
+
+    if (micro) executa_micro();
+    if (macro && executa_macro(gmv_bin, clientes, refs) != 0) return EXIT_FAILURE;
+    grava_csv(stdout);
+
+    if (saida) {
+        FILE *f = fopen(saida, "w");
+        if (!f) { perror(saida); return EXIT_FAILURE; }
+        grava_csv(f);
+        fclose(f);
+    }
+
+    if (baseline) {
+        int regressoes = 0;
+        int r = compara_baseline(baseline, tolerancia, &regressoes);
+        if (regressoes > 0) {
+            /* picos de carga da máquina duram segundos; regressão de verdade
+             * aparece também na repetição, ficando com o melhor de cada linha */
+            static resultado_t primeira[MAX_RESULTADOS];
+            int n = qtd_resultados;
+            memcpy(primeira, resultados, sizeof(resultado_t) * n);
+            fprintf(stderr, "%d regressão(ões); repetindo para confirmar\n", regressoes);
+            qtd_resultados = 0;
+            if (micro) executa_micro();
+            if (macro && executa_macro(gmv_bin, clientes, refs) != 0) return EXIT_FAILURE;
+            melhor_de(primeira, n);
+            r = compara_baseline(baseline, tolerancia, &regressoes);
+        }
+        if (r != 0) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -7,12 +7,14 @@
 
 /**************** Limites do sistema ****************/
 #define ENTRADAS_TP 32      // páginas lógicas por processo
-#define QUADROS_PF  16      // quadros físicos de página
+#ifndef QUADROS_PF
+#define QUADROS_PF  16      // quadros físicos de página (pode ser definido via -D)
+#endif
 #define QTDE_FILHOS 4       // processos no simulador
 
 /**************** Bits de estado da página **********/
 #define BIT_PRESENCA      0x1
-#define BIT_REFERENCIADA  0x2
+#define BIT_REFERENCIADA  0x2   // no GMV o bit R é derivado de epoca_ref
 #define BIT_MODIFICADA    0x4
 
 /**************** Estruturas da tabela de páginas ****/
@@ -20,16 +22,13 @@ typedef struct {
     uint32_t quadro_fisico;   // índice do quadro físico que contém a página
     uint8_t  flags;           // combinação de BIT_*
     uint64_t ultimo_acesso;   // timestamp ou contador
+    uint32_t epoca_ref;       // época em que o bit R foi marcado (0 = nunca)
 } entrada_tp_t;
 
 typedef struct {
     entrada_tp_t entradas[ENTRADAS_TP];
 } tabela_pagina_t;
 
-/**************** Variaveis Globais ********************/
-int contador_paginas_sujas = 0;
-int contador_page_faults = 0;
-
 /**************** Protocolo FIFO ********************/
 /* Pedido que um processo envia ao GMV */
 typedef struct {
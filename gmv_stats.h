@@ -0,0 +1,146 @@
+/* gmv_stats.h – Página de estatísticas em memória compartilhada (GMV, filhos e gmv_top) */
+#ifndef GMV_STATS_H
+#define GMV_STATS_H
+
+#include "gmv_proto.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+/**************** Identificação do segmento *********/
+#define GMV_STATS_PROJ_ID  'S'          // ftok("/tmp", 'S')
+#define GMV_STATS_MAGICO   0x474D5653u  // "GMVS"
+#define GMV_STATS_VERSAO   1
+#define GMV_LINHA_CACHE    64
+
+/**************** Contadores por processo ***********/
+/*
+ * Cada processo ocupa sua própria linha de cache. Os campos de stats_proc_t
+ * são escritos apenas pelo GMV, protegidos pelo seqlock 'seq' (ímpar = escrita
+ * em curso). O que os filhos escrevem fica em stats_espera_t, em linhas
+ * separadas, para não disputar com o GMV as linhas atualizadas a cada pedido.
+ */
+typedef struct {
+    _Atomic uint32_t seq;
+    _Atomic int32_t  pid;
+    _Atomic uint64_t referencias;
+    _Atomic uint64_t hits;
+    _Atomic uint64_t page_faults;
+    _Atomic uint64_t sujas_despejadas;
+    _Atomic uint32_t quadros_ocupados;
+    _Atomic uint32_t working_set;     // páginas residentes referenciadas nas últimas k+1 requisições
+} __attribute__((aligned(GMV_LINHA_CACHE))) stats_proc_t;
+
+/* Latência acumulada de ida e volta ao GMV, somada pelo filho com fetch_add */
+typedef struct {
+    _Atomic uint64_t espera_us;
+} __attribute__((aligned(GMV_LINHA_CACHE))) stats_espera_t;
+
+typedef struct {
+    _Atomic uint32_t magico;          // publicado por último pelo GMV
+    uint32_t         versao;
+    uint32_t         qtd_processos;
+    uint32_t         quadros;
+    _Atomic uint64_t tempo_global;    // requisições atendidas pelo GMV
+    stats_proc_t     proc[QTDE_FILHOS];
+    stats_espera_t   espera[QTDE_FILHOS];   // mesmo índice de proc[]
+} gmv_stats_t;
+
+/* Fotografia consistente de um processo, obtida via seqlock */
+typedef struct {
+    int32_t  pid;
+    uint64_t referencias;
+    uint64_t hits;
+    uint64_t page_faults;
+    uint64_t sujas_despejadas;
+    uint32_t quadros_ocupados;
+    uint32_t working_set;
+    uint64_t espera_us;
+} stats_proc_snap_t;
+
+/* Anexa ao segmento; 'criar' != 0 cria e zera (usado pelo GMV). Um segmento
+ * antigo de outro layout é removido e recriado. Devolve NULL em caso de erro. */
+static inline gmv_stats_t *gmv_stats_anexar(int criar, int somente_leitura) {
+    key_t chave = ftok("/tmp", GMV_STATS_PROJ_ID);
+    if (chave == -1) return NULL;
+    int shm_id = shmget(chave, sizeof(gmv_stats_t), criar ? (IPC_CREAT | 0666) : 0666);
+    if (criar) {
+        struct shmid_ds info;
+        int antigo = (shm_id == -1) ? shmget(chave, 0, 0666) : shm_id;
+        if (antigo != -1 && shmctl(antigo, IPC_STAT, &info) == 0 &&
+            info.shm_segsz != sizeof(gmv_stats_t)) {
+            /* leitores ainda anexados mantêm o segmento velho até se desanexarem */
+            shmctl(antigo, IPC_RMID, NULL);
+            shm_id = shmget(chave, sizeof(gmv_stats_t), IPC_CREAT | IPC_EXCL | 0666);
+        }
+    }
+    if (shm_id == -1) return NULL;
+    gmv_stats_t *st = shmat(shm_id, NULL, somente_leitura ? SHM_RDONLY : 0);
+    if (st == (void *)-1) return NULL;
+    if (criar) {
+        atomic_store_explicit(&st->magico, 0, memory_order_relaxed);
+        memset((char *)st + sizeof(st->magico), 0, sizeof(*st) - sizeof(st->magico));
+        st->versao = GMV_STATS_VERSAO;
+        st->qtd_processos = QTDE_FILHOS;
+        st->quadros = QUADROS_PF;
+        atomic_store_explicit(&st->magico, GMV_STATS_MAGICO, memory_order_release);
+    }
+    return st;
+}
+
+/* Segmento publicado pelo GMV e com layout compatível? */
+static inline int gmv_stats_valido(gmv_stats_t *st) {
+    return st &&
+           atomic_load_explicit(&st->magico, memory_order_acquire) == GMV_STATS_MAGICO &&
+           st->versao == GMV_STATS_VERSAO &&
+           st->qtd_processos == QTDE_FILHOS;
+}
+
+/**************** Escrita (apenas GMV) **************/
+static inline void stats_escrita_inicio(stats_proc_t *p) {
+    uint32_t s = atomic_load_explicit(&p->seq, memory_order_relaxed);
+    atomic_store_explicit(&p->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void stats_escrita_fim(stats_proc_t *p) {
+    uint32_t s = atomic_load_explicit(&p->seq, memory_order_relaxed);
+    atomic_store_explicit(&p->seq, s + 1, memory_order_release);
+}
+
+/* Incremento sem RMW: dentro do seqlock o GMV é o único escritor */
+#define STATS_ADD(campo, v) \
+    atomic_store_explicit(&(campo), atomic_load_explicit(&(campo), memory_order_relaxed) + (v), \
+                          memory_order_relaxed)
+#define STATS_SET(campo, v) atomic_store_explicit(&(campo), (v), memory_order_relaxed)
+
+/**************** Leitura (gmv_top) *****************/
+#define STATS_MAX_TENTATIVAS 100000
+
+/* Devolve 0 com uma fotografia consistente, -1 se o seqlock não estabilizou
+ * (GMV encerrado no meio de uma escrita deixa 'seq' ímpar para sempre). */
+static inline int stats_ler(gmv_stats_t *st, int proc, stats_proc_snap_t *out) {
+    stats_proc_t *p = &st->proc[proc];
+    uint32_t s1, s2 = 0;
+    int tentativas = 0;
+    do {
+        if (tentativas++ == STATS_MAX_TENTATIVAS) return -1;
+        s1 = atomic_load_explicit(&p->seq, memory_order_acquire);
+        if (s1 & 1) continue; // escrita em andamento
+        out->pid              = atomic_load_explicit(&p->pid, memory_order_relaxed);
+        out->referencias      = atomic_load_explicit(&p->referencias, memory_order_relaxed);
+        out->hits             = atomic_load_explicit(&p->hits, memory_order_relaxed);
+        out->page_faults      = atomic_load_explicit(&p->page_faults, memory_order_relaxed);
+        out->sujas_despejadas = atomic_load_explicit(&p->sujas_despejadas, memory_order_relaxed);
+        out->quadros_ocupados = atomic_load_explicit(&p->quadros_ocupados, memory_order_relaxed);
+        out->working_set      = atomic_load_explicit(&p->working_set, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        s2 = atomic_load_explicit(&p->seq, memory_order_relaxed);
+    } while ((s1 & 1) || s1 != s2);
+    out->espera_us = atomic_load_explicit(&st->espera[proc].espera_us, memory_order_relaxed);
+    return 0;
+}
+
+#endif /* GMV_STATS_H */
@@ -0,0 +1,160 @@
+/* gmv_subst.c – Algoritmos de substituição de páginas (usados pelo GMV e pelo gmv_bench) */
+#include "gmv_subst.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+quadro_t memoria_fisica[NUM_QUADROS];
+uint64_t tempo_global = 0;
+uint32_t epoca_ref_atual = 1;
+
+/********************* Implementações simplificadas *************************/
+static int rand_quadro(void) { return rand() % NUM_QUADROS; }
+int select_NRU(tabela_pagina_t *tabelas, int qtd_processos) {
+    //Resolvido - visto
+    int candidatos[4] = {-1, -1, -1, -1};
+
+    /* procura quadro livre imediatamente */
+    for (int i = 0; i < NUM_QUADROS; i++) {
+        if (!memoria_fisica[i].ocupado)
+            return i;
+    }
+
+    /* Classifica quadros ocupados nas 4 classes NRU */
+    for (int i = 0; i < NUM_QUADROS; i++) {
+        quadro_t *q = &memoria_fisica[i]; // q de quadro da memória RAM
+        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
+        bool r = referenciada(e);
+        bool m = (e->flags & BIT_MODIFICADA) != 0;
+        int classe;
+        if (!r && !m)        classe = 0;
+        else if (!r && m)    classe = 1;
+        else if (r && !m)    classe = 2;
+        else                 classe = 3;
+        if (candidatos[classe] == -1)
+            candidatos[classe] = i;
+    }
+
+    /* devolve o primeiro candidato de menor classe disponível */
+    for (int c = 0; c < 4; c++){
+        if (candidatos[c] != -1){
+            return candidatos[c];
+        }
+    }
+    /* fallback improvável */
+    printf("NRU: fallback improvável\n");
+    return rand_quadro();
+}
+int select_2nCh(tabela_pagina_t *tabelas, int qtd_processos) {
+    // Resolvido - visto
+    static int ponteiro = 0;
+
+    for (int tentativas = 0; tentativas < NUM_QUADROS * 2; tentativas++) {
+        int idx = ponteiro % NUM_QUADROS;
+        quadro_t *q = &memoria_fisica[idx];
+
+        if (!q->ocupado) return idx; // Se o quadro atual não estiver ocupado, retorna o índice do quadro
+
+        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
+
+        if (!referenciada(e)){ // Se o bit R não estiver setado, retorna o índice do quadro
+            return idx;
+        } else {
+            limpa_referencia(e); // Se o bit R estiver setado, limpa o bit R
+        }
+
+        ponteiro = (ponteiro + 1) % NUM_QUADROS;
+    }
+    return ponteiro % NUM_QUADROS; 
+}
+int select_LRU(tabela_pagina_t *tabelas, int qtd_processos, int proc_idx) {
+    // LRU com substituição local: prioriza quadros do próprio processo.
+
+    uint64_t menor_tempo_local = UINT64_MAX;
+    int indice_vitima_local = -1;
+
+    /* Primeiro: procura quadro livre; se encontrar, devolve imediatamente */
+    for (int i = 0; i < NUM_QUADROS; ++i) {
+        if (!memoria_fisica[i].ocupado)
+            return i;
+    }
+
+    /* Passo 1: procura LRU entre quadros pertencentes ao processo */
+    for (int i = 0; i < NUM_QUADROS; ++i) {
+        quadro_t *q = &memoria_fisica[i];
+        if (!q->ocupado || q->processo_id != proc_idx)
+            continue; // ignora quadros de outros processos
+
+        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
+        if (e->ultimo_acesso < menor_tempo_local) {
+            menor_tempo_local = e->ultimo_acesso;
+            indice_vitima_local = i;
+        }
+    }
+
+    if (indice_vitima_local != -1)
+        return indice_vitima_local;
+
+    /* Passo 2: processo não possui quadros (ou algum erro); faz fallback global */
+    uint64_t menor_tempo_global = UINT64_MAX;
+    int indice_vitima_global = -1;
+    for (int i = 0; i < NUM_QUADROS; ++i) {
+        quadro_t *q = &memoria_fisica[i];
+        if (!q->ocupado)
+            continue;
+        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
+        if (e->ultimo_acesso < menor_tempo_global) {
+            menor_tempo_global = e->ultimo_acesso;
+            indice_vitima_global = i;
+        }
+    }
+    return indice_vitima_global; // nunca deve ser -1 porque não há quadros livres nessa etapa
+}
+int select_WS(tabela_pagina_t *tabelas, int qtd_processos, int k, int proc_idx) {
+    // Implementação com ponteiro circular para distribuir as vítimas.
+    static int ponteiro = 0;
+
+    uint64_t limite = tempo_global - k; // fronteira da janela k
+
+    int indice_fora_ws = -1;     // primeiro quadro fora do WS encontrado na varredura
+    int indice_mais_antigo = -1; // fallback LRU caso todos estejam no WS
+    uint64_t mais_antigo = UINT64_MAX;
+
+    for (int passo = 0; passo < NUM_QUADROS; ++passo) {
+        int i = (ponteiro + passo) % NUM_QUADROS;
+
+        if (!memoria_fisica[i].ocupado) {
+            // quadro livre pode ser usado por qualquer processo
+            ponteiro = (i + 1) % NUM_QUADROS;
+            return i;
+        }
+
+        // Apenas considera quadros pertencentes ao mesmo processo (substituição local)
+        if (memoria_fisica[i].processo_id != proc_idx) {
+            continue;
+        }
+
+        quadro_t *q = &memoria_fisica[i];
+        entrada_tp_t *e = &tabelas[q->processo_id].entradas[q->pagina_virtual];
+
+        if (e->ultimo_acesso < limite && indice_fora_ws == -1) {
+            indice_fora_ws = i; // primeiro quadro desse processo fora do WS
+        }
+
+        if (e->ultimo_acesso < mais_antigo) {
+            mais_antigo = e->ultimo_acesso;
+            indice_mais_antigo = i;
+        }
+    }
+
+    // Atualiza ponteiro para próximo quadro após a vítima escolhida
+    int escolhido = (indice_fora_ws != -1) ? indice_fora_ws : indice_mais_antigo;
+
+    if (escolhido == -1) {
+        // Situação inesperada: processo não tem quadros próprios e não há livres.
+        // Faz fallback para escolha global via ponteiro.
+        escolhido = ponteiro;
+    }
+
+    ponteiro = (escolhido + 1) % NUM_QUADROS;
+    return escolhido;
+}
@@ -0,0 +1,35 @@
+/* gmv_subst.h – Memória física e algoritmos de substituição compartilhados */
+#ifndef GMV_SUBST_H
+#define GMV_SUBST_H
+
+#include "gmv_proto.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NUM_QUADROS QUADROS_PF
+
+typedef struct {
+    bool ocupado;
+    int processo_id;       // índice do processo proprietário
+    uint8_t pagina_virtual;
+} quadro_t;
+
+extern quadro_t memoria_fisica[NUM_QUADROS];
+extern uint64_t tempo_global;
+
+/* Bit R por época: a página está referenciada se sua marca é igual à época
+ * atual. Zerar todos os bits R equivale a avançar a época; 0 nunca é válida. */
+extern uint32_t epoca_ref_atual;
+
+static inline bool referenciada(const entrada_tp_t *e) { return e->epoca_ref == epoca_ref_atual; }
+static inline void marca_referencia(entrada_tp_t *e)    { e->epoca_ref = epoca_ref_atual; }
+static inline void limpa_referencia(entrada_tp_t *e)    { e->epoca_ref = 0; }
+
+/***************** Protótipos dos algoritmos de substituição ****************/
+// Cada função deve devolver o índice do quadro escolhido para substituição
+int select_NRU(tabela_pagina_t *tabelas, int qtd_processos);
+int select_2nCh(tabela_pagina_t *tabelas, int qtd_processos);
+int select_LRU(tabela_pagina_t *tabelas, int qtd_processos, int proc_idx);
+int select_WS(tabela_pagina_t *tabelas, int qtd_processos, int k, int proc_idx);
+
+#endif /* GMV_SUBST_H */
@@ -0,0 +1,83 @@
+/* gmv_top.c – Monitor externo das estatísticas ao vivo do GMV
+ *
+ * Uso: ./gmv_top [intervalo_ms] [iteracoes]
+ * Apenas lê a página de estatísticas (SHM_RDONLY); nunca bloqueia o GMV.
+ */
+#include "gmv_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static double agora_seg(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Contadores que voltaram a zero indicam GMV reiniciado: conta desde o reinício */
+static uint64_t delta(uint64_t atual, uint64_t anterior) {
+    return atual >= anterior ? atual - anterior : atual;
+}
+
+static void imprime_quadro(stats_proc_snap_t atual[], stats_proc_snap_t anterior[], int ok[],
+                           double dt, uint64_t tempo_global) {
+    printf("\033[H\033[J");
+    printf("gmv_top – requisições atendidas: %llu\n\n", (unsigned long long)tempo_global);
+    printf("Proc |   PID  |  Refs   | Refs/s  |  Hits   |   PF    |  PF/s  | Hit%% | Sujas | Quadros | WS | Espera(us)\n");
+    for (int p = 0; p < QTDE_FILHOS; ++p) {
+        if (!ok[p]) {
+            printf(" P%d  | GMV inconsistente/parado\n", p + 1);
+            continue;
+        }
+        stats_proc_snap_t *a = &atual[p], zero = {0};
+        stats_proc_snap_t *b = (a->pid == anterior[p].pid) ? &anterior[p] : &zero;
+        uint64_t d_refs = delta(a->referencias, b->referencias);
+        uint64_t d_pf   = delta(a->page_faults, b->page_faults);
+        uint64_t d_esp  = delta(a->espera_us, b->espera_us);
+        double hit = a->referencias ? 100.0 * a->hits / a->referencias : 0.0;
+        printf(" P%d  | %6d | %7llu | %7.1f | %7llu | %7llu | %6.1f | %4.0f | %5llu | %7u | %2u | %10.1f\n",
+               p + 1, a->pid,
+               (unsigned long long)a->referencias, d_refs / dt,
+               (unsigned long long)a->hits,
+               (unsigned long long)a->page_faults, d_pf / dt,
+               hit,
+               (unsigned long long)a->sujas_despejadas,
+               a->quadros_ocupados, a->working_set,
+               d_refs ? (double)d_esp / d_refs : 0.0);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    int intervalo_ms = (argc >= 2) ? atoi(argv[1]) : 1000;
+    int iteracoes    = (argc >= 3) ? atoi(argv[2]) : 0; // 0 = até Ctrl-C
+    if (intervalo_ms <= 0) intervalo_ms = 1000;
+
+    gmv_stats_t *st = gmv_stats_anexar(0, 1);
+    if (!st) { perror("shm stats (GMV em execução?)"); return EXIT_FAILURE; }
+    if (!gmv_stats_valido(st)) {
+        fprintf(stderr, "Página de estatísticas incompatível (esperado versão %d)\n", GMV_STATS_VERSAO);
+        return EXIT_FAILURE;
+    }
+
+    stats_proc_snap_t anterior[QTDE_FILHOS] = {{0}}, atual[QTDE_FILHOS];
+    int ok[QTDE_FILHOS];
+    for (int p = 0; p < QTDE_FILHOS; ++p)
+        if (stats_ler(st, p, &anterior[p]) != 0)
+            memset(&anterior[p], 0, sizeof(anterior[p])); // descarta leitura rasgada
+    double t_ant = agora_seg();
+
+    for (int it = 0; iteracoes == 0 || it < iteracoes; ++it) {
+        usleep(intervalo_ms * 1000);
+        for (int p = 0; p < QTDE_FILHOS; ++p) ok[p] = (stats_ler(st, p, &atual[p]) == 0);
+        double t = agora_seg();
+        imprime_quadro(atual, anterior, ok, t - t_ant,
+                       atomic_load_explicit(&st->tempo_global, memory_order_relaxed));
+        for (int p = 0; p < QTDE_FILHOS; ++p) if (ok[p]) anterior[p] = atual[p];
+        t_ant = t;
+    }
+
+    shmdt(st);
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <errno.h>
 #include <time.h>
 #include "gmv_proto.h"
+#include "gmv_stats.h"
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -22,9 +23,12 @@
 static int RODADAS_TOTAIS = 100;
 
 //Variaveis globais
+int contador_paginas_sujas = 0;
+int contador_page_faults = 0;
 char paginas_filhos[QTDE_FILHOS][QTDE_ACESSOS][6]; // Ex: "23 W\0"
 int *contador_compartilhado = NULL;
 int *contador_pag_sujas_shared = NULL; // novo ponteiro para páginas sujas
+gmv_stats_t *stats_compartilhado = NULL; // página de estatísticas criada pelo GMV
 
 // Protótipos
 static void rotina_filho(int id);
@@ -34,6 +38,7 @@ static void imprimir_amostra();
 static void exibir_relatorio_final(const char *algoritmo, int k_param, int rodadas,
                                    int total_pf, int dirty_pages);
 static void salvar_acessos_arquivos();
+static void registra_espera(const struct timespec *ini, const struct timespec *fim);
 
 int main(int argc, char *argv[]) {
     /* Parametros: argv[1] = rodadas, opcional */
@@ -65,6 +70,10 @@ int main(int argc, char *argv[]) {
     contador_pag_sujas_shared = shmat(shmid_dp, NULL, 0);
     if (contador_pag_sujas_shared == (void *)-1) { perror("shmat dirty"); exit(1); }
 
+    /* anexa à página de estatísticas (opcional) */
+    stats_compartilhado = gmv_stats_anexar(0, 0);
+    if (!gmv_stats_valido(stats_compartilhado)) stats_compartilhado = NULL;
+
     /* garante diretório de FIFOs */
     mkdir("./FIFOs", 0777);
     /* cria FIFO de requisições se ainda não existir */
@@ -134,6 +143,7 @@ int main(int argc, char *argv[]) {
     shmdt(contador_compartilhado);      /* desanexa */
     shmctl(shmid, IPC_RMID, NULL);      /* remove o segmento */
     shmdt(contador_pag_sujas_shared);
+    if (stats_compartilhado) shmdt(stats_compartilhado);
     return 0;
 }
 
@@ -172,11 +182,16 @@ static void rotina_filho(int id) {
 
         /* monta requisição e envia ao GMV */
         req_t req = { .pid = getpid(), .pagina = (uint8_t)pagina, .operacao = operacao };
+        struct timespec t_ini, t_fim;
+        clock_gettime(CLOCK_MONOTONIC, &t_ini);
         write(fd_req, &req, sizeof(req));
 
         /* lê resposta */
         resp_t resp;
-        if (read(fd_resp, &resp, sizeof(resp)) == sizeof(resp)) {
+        ssize_t lidos = read(fd_resp, &resp, sizeof(resp));
+        clock_gettime(CLOCK_MONOTONIC, &t_fim);
+        registra_espera(&t_ini, &t_fim);
+        if (lidos == sizeof(resp)) {
             printf("    -> quadro %d (page_fault=%d)\n", resp.quadro, resp.page_fault);
         }
         
@@ -197,6 +212,21 @@ static void rotina_filho(int id) {
     shmdt(contador_compartilhado);
 }
 
+/* Soma a latência da requisição no slot que o GMV atribuiu a este pid */
+static void registra_espera(const struct timespec *ini, const struct timespec *fim) {
+    static int slot = -1;
+    if (!stats_compartilhado) return;
+    if (slot < 0) {
+        for (int i = 0; i < QTDE_FILHOS; ++i)
+            if (atomic_load_explicit(&stats_compartilhado->proc[i].pid, memory_order_relaxed) == getpid())
+                slot = i;
+        if (slot < 0) return;
+    }
+    uint64_t us = (uint64_t)(fim->tv_sec - ini->tv_sec) * 1000000u +
+                  (fim->tv_nsec - ini->tv_nsec) / 1000;
+    atomic_fetch_add_explicit(&stats_compartilhado->espera[slot].espera_us, us, memory_order_relaxed);
+}
+
 static void gerar_acessos_vetor() {
     srand(time(NULL));
 